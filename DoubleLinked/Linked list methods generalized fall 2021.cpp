@@ -5,6 +5,19 @@
 #include <iostream>
 #include <memory>
 #include <stdexcept>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <random>
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <algorithm>
 
 using std::cin;
 using std::cout;
@@ -14,374 +27,1519 @@ using std::string;
 using std::stringstream;
 using std::make_shared;
 using std::shared_ptr;
+using std::vector;
 
 
 //******************
 //The node class
 //******************
-template <typename T>
+template <typename T, bool Tombstone = false>
 class Node {
 public:
     T data{};
-    shared_ptr<Node<T>> prev{ nullptr };
-    shared_ptr<Node<T>> next{ nullptr };
+    shared_ptr<Node<T, Tombstone>> prev{ nullptr };
+    shared_ptr<Node<T, Tombstone>> next{ nullptr };
+
+};
+
+// Nodes of a list using the LazyDelete policy carry a tombstone flag
+template <typename T>
+class Node<T, true> {
+public:
+    T data{};
+    shared_ptr<Node<T, true>> prev{ nullptr };
+    shared_ptr<Node<T, true>> next{ nullptr };
+    bool deleted{ false }; // tombstone, only set in lazy deletion mode
+
+};
+
+//******************
+//Policies for the list classes, bundled together by ListPolicies.
+//A disabled policy is an empty class whose hooks are empty inline functions or whose flag
+//turns code off through if constexpr, so the list pays no code and no storage for it.
+//******************
+
+// CountPolicy: CountNodes keeps live and tombstone counts, NoCount counts by walking when asked
+struct CountNodes {
+    static constexpr bool enabled = true;
+protected:
+    void countLinked() { liveNodes++; }
+    void countUnlinked(const bool dead) { if (dead) { deadNodes--; } else { liveNodes--; } }
+    void countMarkedDead() { liveNodes--; deadNodes++; }
+    unsigned int liveNodes{ 0 };
+    unsigned int deadNodes{ 0 };
+};
+
+struct NoCount {
+    static constexpr bool enabled = false;
+protected:
+    void countLinked() {}
+    void countUnlinked(const bool) {}
+    void countMarkedDead() {}
+};
+
+// CheckPolicy: CheckBounds throws out_of_range for bad indexes, with NoBoundsCheck a bad index is undefined behavior
+struct CheckBounds {
+    static constexpr bool enabled = true;
+};
+
+struct NoBoundsCheck {
+    static constexpr bool enabled = false;
+};
+
+// DiagnosticsPolicy: the messages printed by deleteFirst/deleteLast and the base class method stubs
+struct PrintDiagnostics {
+    static constexpr bool enabled = true;
+};
+
+struct NoDiagnostics {
+    static constexpr bool enabled = false;
+};
+
+// AllocPolicy: how a single node is created, and the contiguous block of nodes a copy is built in.
+// createBlock returns a handle to the first node that owns the whole block.
+struct MakeSharedAlloc {
+    template <typename N>
+    static shared_ptr<N> create() { return make_shared<N>(); }
+
+    template <typename N>
+    static shared_ptr<N> createBlock(const size_t count) { return shared_ptr<N>(new N[count], std::default_delete<N[]>()); }
+};
+
+template <typename Allocator>
+struct AllocateSharedWith {
+    template <typename N>
+    static shared_ptr<N> create() { return std::allocate_shared<N>(Allocator{}); }
+
+    template <typename N>
+    static shared_ptr<N> createBlock(const size_t count);
+};
+
+template <typename Allocator>
+template <typename N>
+shared_ptr<N> AllocateSharedWith<Allocator>::createBlock(const size_t count) {
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<N> NodeAllocator;
+    typedef std::allocator_traits<NodeAllocator> Traits;
+
+    NodeAllocator allocator{ Allocator{} };
+    N* nodes = Traits::allocate(allocator, count);
+    size_t constructed = 0;
+    try {
+        for (; constructed < count; constructed++) {
+            Traits::construct(allocator, nodes + constructed);
+        }
+    }
+    catch (...) {
+        while (constructed > 0) {
+            Traits::destroy(allocator, nodes + --constructed);
+        }
+        Traits::deallocate(allocator, nodes, count);
+        throw;
+    }
+    // The control block comes from the allocator too, and the deleter runs if allocating it throws
+    return shared_ptr<N>(nodes, [count](N* block) {
+        NodeAllocator allocator{ Allocator{} };
+        for (size_t i = 0; i < count; i++) {
+            Traits::destroy(allocator, block + i);
+        }
+        Traits::deallocate(allocator, block, count);
+    }, allocator);
+}
+
+// DeletePolicy: EagerDelete unlinks every removed node, and its nodes have no tombstone flag.
+// LazyDelete lets removes only mark nodes as tombstones, see setLazyDeletion.
+struct EagerDelete {
+    static constexpr bool enabled = false;
+};
+
+struct LazyDelete {
+    static constexpr bool enabled = true;
+protected:
+    bool lazyDeletion{ false };
+    double compactionRatio{ 0.5 };
+};
+
+// How clear(), assignment and the destructor release the nodes of a list
+enum class ReclaimMode {
+    Immediate,   // freed on the calling thread before returning
+    Background,  // detached in O(1) and freed by the ChainReclaimer thread
+    Incremental  // clear() detaches in O(1), then each new node frees a chunk; the destructor frees the rest
+};
+
+// ReclaimPolicy: with ImmediateReclaim clear(), assignment and the destructor free the nodes right away.
+// DeferredReclaim adds setReclaimMode and keeps the mode, and the chains Incremental mode hasn't freed yet.
+struct ImmediateReclaim {
+    static constexpr bool enabled = false;
+
+    template <typename N>
+    struct State {};
+};
 
+struct DeferredReclaim {
+    static constexpr bool enabled = true;
+
+    template <typename N>
+    struct State {
+    protected:
+        ReclaimMode reclaimMode{ ReclaimMode::Immediate };
+        unsigned int reclaimChunk{ 1024 };
+        // Chains detached by clear() in Incremental mode, linked one after another through next
+        shared_ptr<N> pendingFirst{ nullptr };
+        shared_ptr<N> pendingLast{ nullptr };
+    };
 };
 
+// ThreadPolicy: every public list method holds lockList() for its duration, and moves hold
+// lockBoth() on the two lists, which takes the locks in a deadlock free order.
+// The mutex is recursive because public methods call each other, e.g. insert(0, ...) calls pushFront.
+struct SingleThreaded {
+protected:
+    struct NoLock {};
+    NoLock lockList() const { return NoLock{}; }
+    NoLock lockBoth(const SingleThreaded&) const { return NoLock{}; }
+};
+
+struct MutexLocked {
+protected:
+    std::unique_lock<std::recursive_mutex> lockList() const { return std::unique_lock<std::recursive_mutex>(listMutex); }
+    std::scoped_lock<std::recursive_mutex, std::recursive_mutex> lockBoth(const MutexLocked& other) const {
+        return std::scoped_lock<std::recursive_mutex, std::recursive_mutex>(listMutex, other.listMutex);
+    }
+    mutable std::recursive_mutex listMutex;
+};
+
+template <typename CountPolicy = CountNodes, typename CheckPolicy = CheckBounds, typename DiagnosticsPolicy = PrintDiagnostics,
+    typename AllocPolicy = MakeSharedAlloc, typename ThreadPolicy = SingleThreaded, typename DeletePolicy = EagerDelete,
+    typename ReclaimPolicy = ImmediateReclaim>
+struct ListPolicies {
+    typedef CountPolicy Count;
+    typedef CheckPolicy Check;
+    typedef DiagnosticsPolicy Diagnostics;
+    typedef AllocPolicy Alloc;
+    typedef ThreadPolicy Thread;
+    typedef DeletePolicy Delete;
+    typedef ReclaimPolicy Reclaim;
+};
+
+// The default policies with lazy deletion
+typedef ListPolicies<CountNodes, CheckBounds, PrintDiagnostics, MakeSharedAlloc, SingleThreaded, LazyDelete> LazyDeletePolicies;
+// The default policies with deferred reclaiming
+typedef ListPolicies<CountNodes, CheckBounds, PrintDiagnostics, MakeSharedAlloc, SingleThreaded, EagerDelete, DeferredReclaim> DeferredReclaimPolicies;
+
+//******************
+//The background reclaimer
+//A single worker thread that frees chains detached from lists, so the thread that clears or destroys
+//a long list doesn't pay for freeing it.  Jobs run in the order they were handed over.
+//The reclaimer is never destroyed, so lists that outlive it at exit can still reach it.  It shuts
+//down at exit instead, after which enqueue() refuses jobs and callers free on their own thread.
+//******************
+class ChainReclaimer {
+public:
+    static ChainReclaimer& instance();
+    bool enqueue(std::function<void()> job);
+    void waitUntilIdle();
+    void shutDown();
+
+private:
+    ChainReclaimer();
+    void run();
+    static void shutDownAtExit();
+
+    std::mutex lock;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::deque<std::function<void()>> jobs;
+    bool busy{ false };
+    bool stopping{ false };
+    std::thread worker;
+};
+
+ChainReclaimer& ChainReclaimer::instance() {
+    // Intentionally leaked, see the class comment
+    static ChainReclaimer* reclaimer = []() {
+        ChainReclaimer* created = new ChainReclaimer();
+        std::atexit(&ChainReclaimer::shutDownAtExit);
+        return created;
+    }();
+    return *reclaimer;
+}
+
+void ChainReclaimer::shutDownAtExit() {
+    instance().shutDown();
+}
+
+ChainReclaimer::ChainReclaimer() {
+    worker = std::thread(&ChainReclaimer::run, this);
+}
+
+// Finishes every queued job, then stops the worker.  Later jobs are refused.
+void ChainReclaimer::shutDown() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (stopping) {
+            return;
+        }
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+// Returns false, leaving job untouched, once the reclaimer has shut down
+bool ChainReclaimer::enqueue(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (stopping) {
+            return false;
+        }
+        jobs.push_back(std::move(job));
+    }
+    wake.notify_one();
+    return true;
+}
+
+void ChainReclaimer::waitUntilIdle() {
+    std::unique_lock<std::mutex> guard(lock);
+    idle.wait(guard, [this]() { return jobs.empty() && !busy; });
+}
+
+void ChainReclaimer::run() {
+    std::unique_lock<std::mutex> guard(lock);
+    while (true) {
+        wake.wait(guard, [this]() { return stopping || !jobs.empty(); });
+        if (jobs.empty()) {
+            // stopping and drained
+            return;
+        }
+        std::function<void()> job{ std::move(jobs.front()) };
+        jobs.pop_front();
+        busy = true;
+        guard.unlock();
+        job();
+        // Destroy the job, and whatever it still holds, outside the lock
+        job = nullptr;
+        guard.lock();
+        busy = false;
+        if (jobs.empty()) {
+            idle.notify_all();
+        }
+    }
+}
+
+// MSVC only gives more than one empty base class zero size when asked to
+#ifdef _MSC_VER
+#define LIST_EMPTY_BASES __declspec(empty_bases)
+#else
+#define LIST_EMPTY_BASES
+#endif
+
 //******************
 //The linked list base class
 //This contains within it a class declaration for an iterator
 //******************
-template <typename T>
-class BaseDoublyLinkedList {
+template <typename T, typename Policies = ListPolicies<>>
+class LIST_EMPTY_BASES BaseDoublyLinkedList : protected Policies::Count, protected Policies::Thread, protected Policies::Delete,
+    protected Policies::Reclaim::template State<Node<T, Policies::Delete::enabled>> {
 public:
+    typedef Node<T, Policies::Delete::enabled> ListNode;
 
     //public members of the DoublyLinkedList class
+    BaseDoublyLinkedList() = default;
+    BaseDoublyLinkedList(const BaseDoublyLinkedList& other);
+    BaseDoublyLinkedList(BaseDoublyLinkedList&& other) noexcept;
+    BaseDoublyLinkedList& operator=(const BaseDoublyLinkedList& other);
+    BaseDoublyLinkedList& operator=(BaseDoublyLinkedList&& other) noexcept;
     ~BaseDoublyLinkedList();
+    void clear();
+
+    // Deferred destruction, see ReclaimMode.  setReclaimMode needs the DeferredReclaim policy.
+    void setReclaimMode(const ReclaimMode mode, const unsigned int chunkSize = 1024);
+    unsigned int reclaimPending(const unsigned int maxNodes);
+    bool hasPendingReclaim() const;
     string getListAsString();
     string getListBackwardsAsString();
     void pushFront(const T&);
     void pushBack(const T&);
     void deleteFirst();
     void deleteLast();
-    T get(const unsigned int index) const { cerr << "Error: You didn't override this base class method yet" << endl; T temp{}; return temp; }
-    T& operator[](const unsigned int index) const { cerr << "Error: You didn't override this base class method yet" << endl; T temp{}; return temp; }
-    void insert(const unsigned int index, const T& value) { cerr << "Error: You didn't override this base class method yet" << endl; }
-    void remove(const unsigned int index) { cerr << "Error: You didn't override this base class method yet" << endl; }
-    void removeAllInstances(const T& value) { cerr << "Error: You didn't override this base class method yet" << endl; }
+    T get(const unsigned int index) const { notOverridden(); T temp{}; return temp; }
+    T& operator[](const unsigned int index) const { notOverridden(); T temp{}; return temp; }
+    void insert(const unsigned int index, const T& value) { notOverridden(); }
+    void remove(const unsigned int index) { notOverridden(); }
+    void removeAllInstances(const T& value) { notOverridden(); }
+
+    // Lazy deletion: removes only mark nodes as tombstones, which are unlinked in batches by compact().
+    // Only available with the LazyDelete policy.
+    void setLazyDeletion(const bool enabled);
+    void setCompactionRatio(const double ratio);
+    void compact();
+    unsigned int getLiveCount() const;
+    unsigned int getDeadCount() const;
+
+    // Flips the direction of the whole list in O(1), every method honours the direction
+    void reverse();
+    bool isReversed() const;
+    // Moves the first k values to the back (the last -k values to the front when k is negative) without allocating
+    void rotate(const int k);
 
 protected:
-    shared_ptr<Node<T>> first{ nullptr };
-    shared_ptr<Node<T>> last{ nullptr };
-    // Yes, you're reading that correctly, this code has no count variable!
+    static void notOverridden() {
+        if constexpr (Policies::Diagnostics::enabled) {
+            cerr << "Error: You didn't override this base class method yet" << endl;
+        }
+    }
+    shared_ptr<ListNode> newNode();
+    void copyFrom(const BaseDoublyLinkedList& other);
+    static shared_ptr<ListNode> freeChain(shared_ptr<ListNode> chain, unsigned int maxNodes = std::numeric_limits<unsigned int>::max());
+    static shared_ptr<ListNode> dropFront(shared_ptr<ListNode> node);
+    static void releaseValue(const shared_ptr<ListNode>& node);
+    static void handOff(shared_ptr<ListNode> chain) noexcept;
+    string listAsString(const bool forwards) const;
+
+    // first/last/next/prev are physical, head/tail/step/stepBack follow the direction of the list
+    shared_ptr<ListNode> head() const { return reversed ? last : first; }
+    shared_ptr<ListNode> tail() const { return reversed ? first : last; }
+    shared_ptr<ListNode> step(const shared_ptr<ListNode>& node) const { return reversed ? node->prev : node->next; }
+    shared_ptr<ListNode> stepBack(const shared_ptr<ListNode>& node) const { return reversed ? node->next : node->prev; }
+
+    shared_ptr<ListNode> findLiveNode(const unsigned int index) const;
+    void linkFirst(const shared_ptr<ListNode>& node);
+    void linkLast(const shared_ptr<ListNode>& node);
+    void linkAfter(const shared_ptr<ListNode>& prior, const shared_ptr<ListNode>& node);
+    void linkBefore(const shared_ptr<ListNode>& next, const shared_ptr<ListNode>& node);
+    void unlinkNode(shared_ptr<ListNode> node);
+    void dropNode(shared_ptr<ListNode> node);
+    void markDead(const shared_ptr<ListNode>& node);
+    void compactIfNeeded();
+
+    // Without the LazyDelete policy there are no tombstones and both are constant false
+    static bool isDead(const shared_ptr<ListNode>& node) {
+        if constexpr (Policies::Delete::enabled) {
+            return node->deleted;
+        }
+        else {
+            return false;
+        }
+    }
+    bool lazyMode() const {
+        if constexpr (Policies::Delete::enabled) {
+            return this->lazyDeletion;
+        }
+        else {
+            return false;
+        }
+    }
+
+    // A copy allocates its nodes in blocks of at most this many, see copyFrom
+    static constexpr unsigned int copyBlockNodes = 64;
+
+    shared_ptr<ListNode> first{ nullptr };
+    shared_ptr<ListNode> last{ nullptr };
+    bool reversed{ false };
 };
 
-template <typename T>// destructor
-BaseDoublyLinkedList<T>::~BaseDoublyLinkedList() {
-    while (first != last) {
-        first = first->next;
-        first->prev.reset();
+template <typename T, typename Policies>// copy constructor, a deep copy of the live values
+BaseDoublyLinkedList<T, Policies>::BaseDoublyLinkedList(const BaseDoublyLinkedList<T, Policies>& other) {
+    [[maybe_unused]] auto guard = other.lockList();
+    copyFrom(other);
+}
+
+template <typename T, typename Policies>// move constructor
+BaseDoublyLinkedList<T, Policies>::BaseDoublyLinkedList(BaseDoublyLinkedList<T, Policies>&& other) noexcept {
+    *this = std::move(other);
+}
+
+template <typename T, typename Policies>
+BaseDoublyLinkedList<T, Policies>& BaseDoublyLinkedList<T, Policies>::operator=(const BaseDoublyLinkedList<T, Policies>& other) {
+    if (this != &other) {
+        // Build the copy first so this list is untouched if copying a value throws
+        BaseDoublyLinkedList<T, Policies> temp(other);
+        *this = std::move(temp);
     }
+    return *this;
 }
 
-template <typename T>
-void BaseDoublyLinkedList<T>::pushFront(const T& item) {
-    shared_ptr<Node<T>> temp = make_shared<Node<T>>();
+template <typename T, typename Policies>
+BaseDoublyLinkedList<T, Policies>& BaseDoublyLinkedList<T, Policies>::operator=(BaseDoublyLinkedList<T, Policies>&& other) noexcept {
+    if (this != &other) {
+        [[maybe_unused]] auto guard = this->lockBoth(other);
+        clear();
+        first = std::move(other.first);
+        last = std::move(other.last);
+        static_cast<typename Policies::Count&>(*this) = static_cast<typename Policies::Count&>(other);
+        static_cast<typename Policies::Count&>(other) = typename Policies::Count{};
+        static_cast<typename Policies::Delete&>(*this) = static_cast<typename Policies::Delete&>(other);
+        reversed = other.reversed;
+        other.reversed = false;
+        if constexpr (Policies::Reclaim::enabled) {
+            this->reclaimMode = other.reclaimMode;
+            this->reclaimChunk = other.reclaimChunk;
+        }
+    }
+    return *this;
+}
+
+template <typename T, typename Policies>// destructor
+BaseDoublyLinkedList<T, Policies>::~BaseDoublyLinkedList() {
+    clear();
+    // Nothing may outlive the list except what the background thread owns
+    if constexpr (Policies::Reclaim::enabled) {
+        if (this->pendingFirst) {
+            this->pendingLast.reset();
+            if (this->reclaimMode == ReclaimMode::Background) {
+                handOff(std::move(this->pendingFirst));
+            }
+            else {
+                freeChain(std::move(this->pendingFirst));
+            }
+        }
+    }
+}
+
+// Detaches the whole chain in O(1), then frees it as the ReclaimMode says
+template <typename T, typename Policies>
+void BaseDoublyLinkedList<T, Policies>::clear() {
+    [[maybe_unused]] auto guard = this->lockList();
+    shared_ptr<ListNode> chain{ std::move(first) };
+    shared_ptr<ListNode> chainLast{ std::move(last) };
+    static_cast<typename Policies::Count&>(*this) = typename Policies::Count{};
+    if (!chain) {
+        return;
+    }
+
+    if constexpr (Policies::Reclaim::enabled) {
+        if (this->reclaimMode == ReclaimMode::Incremental) {
+            if (this->pendingLast) {
+                this->pendingLast->next = std::move(chain);
+            }
+            else {
+                this->pendingFirst = std::move(chain);
+            }
+            this->pendingLast = std::move(chainLast);
+            return;
+        }
+        if (this->reclaimMode == ReclaimMode::Background) {
+            chainLast.reset();
+            handOff(std::move(chain));
+            return;
+        }
+    }
+    chainLast.reset();
+    freeChain(std::move(chain));
+}
+
+// Frees up to maxNodes nodes from the front of a detached chain, one at a time.  Returns what is left of the chain.
+template <typename T, typename Policies>
+auto BaseDoublyLinkedList<T, Policies>::freeChain(shared_ptr<ListNode> chain, unsigned int maxNodes) -> shared_ptr<ListNode> {
+    while (chain && maxNodes > 0) {
+        chain = dropFront(std::move(chain));
+        maxNodes--;
+    }
+    return chain;
+}
+
+// Drops the front node of a detached chain and returns the rest.  Both links are cleared first,
+// so the node's destructor never recurses into its neighbours.
+template <typename T, typename Policies>
+auto BaseDoublyLinkedList<T, Policies>::dropFront(shared_ptr<ListNode> node) -> shared_ptr<ListNode> {
+    shared_ptr<ListNode> rest{ std::move(node->next) };
+    if (rest) {
+        rest->prev.reset();
+    }
+    node->prev.reset();
+    releaseValue(node);
+    return rest;
+}
+
+// Nodes of a copied list share a block, which is freed with its last node.  A node that isn't the
+// last owner of its allocation gives up its value now, so a removed value never waits on its block.
+template <typename T, typename Policies>
+void BaseDoublyLinkedList<T, Policies>::releaseValue(const shared_ptr<ListNode>& node) {
+    if constexpr (!std::is_trivially_destructible<T>::value) {
+        if (node.use_count() > 1) {
+            node->data = T{};
+        }
+    }
+}
+
+// Never throws, so it is safe from clear() inside the noexcept move operations and the destructor.
+// If the reclaimer can't take the chain (shut down, thread creation or allocation failed), it is freed here.
+template <typename T, typename Policies>
+void BaseDoublyLinkedList<T, Policies>::handOff(shared_ptr<ListNode> chain) noexcept {
+    bool queued = false;
+    try {
+        queued = ChainReclaimer::instance().enqueue([chain]() mutable { freeChain(std::move(chain)); });
+    }
+    catch (...) {
+        queued = false;
+    }
+    if (!queued) {
+        freeChain(std::move(chain));
+    }
+}
+
+template <typename T, typename Policies>
+void BaseDoublyLinkedList<T, Policies>::setReclaimMode(const ReclaimMode mode, const unsigned int chunkSize) {
+    static_assert(Policies::Reclaim::enabled, "Reclaim modes need the DeferredReclaim policy");
+    [[maybe_unused]] auto guard = this->lockList();
+    if (chunkSize == 0) {
+        throw std::invalid_argument("Reclaim chunk size must be at least one node");
+    }
+    this->reclaimMode = mode;
+    this->reclaimChunk = chunkSize;
+    // Leftovers from Incremental mode are released the new way
+    if (mode != ReclaimMode::Incremental && this->pendingFirst) {
+        this->pendingLast.reset();
+        if (mode == ReclaimMode::Background) {
+            handOff(std::move(this->pendingFirst));
+        }
+        else {
+            freeChain(std::move(this->pendingFirst));
+        }
+        this->pendingFirst.reset();
+    }
+}
+
+// Frees up to maxNodes nodes detached by clear() in Incremental mode, returns how many were freed
+template <typename T, typename Policies>
+unsigned int BaseDoublyLinkedList<T, Policies>::reclaimPending(const unsigned int maxNodes) {
+    unsigned int freed = 0;
+    if constexpr (Policies::Reclaim::enabled) {
+        [[maybe_unused]] auto guard = this->lockList();
+        while (this->pendingFirst && freed < maxNodes) {
+            if (this->pendingFirst == this->pendingLast) {
+                this->pendingLast.reset();
+            }
+            this->pendingFirst = dropFront(std::move(this->pendingFirst));
+            freed++;
+        }
+    }
+    return freed;
+}
+
+template <typename T, typename Policies>
+bool BaseDoublyLinkedList<T, Policies>::hasPendingReclaim() const {
+    if constexpr (Policies::Reclaim::enabled) {
+        [[maybe_unused]] auto guard = this->lockList();
+        return this->pendingFirst != nullptr;
+    }
+    else {
+        return false;
+    }
+}
+
+// Every new node pays off a chunk of what an Incremental clear() left behind
+template <typename T, typename Policies>
+auto BaseDoublyLinkedList<T, Policies>::newNode() -> shared_ptr<ListNode> {
+    if constexpr (Policies::Reclaim::enabled) {
+        if (this->pendingFirst) {
+            reclaimPending(this->reclaimChunk);
+        }
+    }
+    return Policies::Alloc::template create<ListNode>();
+}
+
+// Allocates the nodes of the copy in contiguous blocks of up to copyBlockNodes and links them in a single pass.
+// Each node handle aliases its block, so a block lives until the last of its nodes is released.  Bounding
+// the blocks bounds what a few surviving nodes can keep allocated, and what freeing one node can cost.
+// The values are copied in the order other presents them, so the copy is never reversed.
+template <typename T, typename Policies>
+void BaseDoublyLinkedList<T, Policies>::copyFrom(const BaseDoublyLinkedList<T, Policies>& other) {
+    static_cast<typename Policies::Delete&>(*this) = static_cast<const typename Policies::Delete&>(other);
+    if constexpr (Policies::Reclaim::enabled) {
+        this->reclaimMode = other.reclaimMode;
+        this->reclaimChunk = other.reclaimChunk;
+    }
+    const unsigned int count = other.getLiveCount();
+    if (count == 0) {
+        return;
+    }
+
+    shared_ptr<ListNode> chainFirst;
+    shared_ptr<ListNode> chainLast;
+    shared_ptr<ListNode> block;
+    unsigned int i = 0;
+    try {
+        for (shared_ptr<ListNode> currentNode{ other.head() }; currentNode; currentNode = other.step(currentNode)) {
+            if (isDead(currentNode)) {
+                continue;
+            }
+            if (i % copyBlockNodes == 0) {
+                const unsigned int remaining = count - i;
+                block = Policies::Alloc::template createBlock<ListNode>(remaining < copyBlockNodes ? remaining : copyBlockNodes);
+            }
+            shared_ptr<ListNode> node(block, block.get() + i % copyBlockNodes);
+            if constexpr (std::is_trivially_copyable<T>::value) {
+                std::memcpy(&node->data, &currentNode->data, sizeof(T));
+            }
+            else {
+                node->data = currentNode->data;
+            }
+            if (chainLast) {
+                node->prev = chainLast;
+                chainLast->next = node;
+            }
+            else {
+                chainFirst = node;
+            }
+            chainLast = std::move(node);
+            i++;
+        }
+    }
+    catch (...) {
+        // The links between the nodes keep their blocks alive, so break them before giving up
+        chainLast.reset();
+        freeChain(std::move(chainFirst));
+        throw;
+    }
+    first = std::move(chainFirst);
+    last = std::move(chainLast);
+    for (unsigned int j = 0; j < i; j++) {
+        this->countLinked();
+    }
+}
+
+template <typename T, typename Policies>
+void BaseDoublyLinkedList<T, Policies>::pushFront(const T& item) {
+    [[maybe_unused]] auto guard = this->lockList();
+    shared_ptr<ListNode> temp = newNode();
 
     temp->data = item;
-    if (!first) {
-        // Scenario: List is empty
-        last = temp;
+    if (reversed) {
+        linkLast(temp);
     }
     else {
-        first->prev = temp;
-        temp->next = first;
+        linkFirst(temp);
     }
-    first = temp;
 }
 
-template <typename T>
-void BaseDoublyLinkedList<T>::pushBack(const T& item) {
-    shared_ptr<Node<T>> temp = make_shared<Node<T>>();
+template <typename T, typename Policies>
+void BaseDoublyLinkedList<T, Policies>::pushBack(const T& item) {
+    [[maybe_unused]] auto guard = this->lockList();
+    shared_ptr<ListNode> temp = newNode();
 
     temp->data = item;
+    if (reversed) {
+        linkFirst(temp);
+    }
+    else {
+        linkLast(temp);
+    }
+}
+
+template <typename T, typename Policies>
+void BaseDoublyLinkedList<T, Policies>::linkFirst(const shared_ptr<ListNode>& node) {
+    this->countLinked();
+    if (!first) {
+        // Scenario: List is empty
+        last = node;
+    }
+    else {
+        first->prev = node;
+        node->next = first;
+    }
+    first = node;
+}
+
+template <typename T, typename Policies>
+void BaseDoublyLinkedList<T, Policies>::linkLast(const shared_ptr<ListNode>& node) {
+    this->countLinked();
     if (!first) {
         // Scenario: List is empty
-        first = temp;
+        first = node;
     }
     else {
-        last->next = temp;
-        temp->prev = last;
+        last->next = node;
+        node->prev = last;
     }
-    last = temp;
+    last = node;
 }
 
 
-template<typename T>
-void BaseDoublyLinkedList<T>::deleteFirst() {
+template <typename T, typename Policies>
+void BaseDoublyLinkedList<T, Policies>::deleteFirst() {
 
     // Design pattern when programming these API calls
     // Handle error scenarios first
     // Handle edge/special scenarios next
     // Handle the general scenario last
 
+    [[maybe_unused]] auto guard = this->lockList();
+
+    // Tombstones in front of the first live node are garbage anyway, drop them now
+    while (this->head() && isDead(this->head())) {
+        this->dropNode(this->head());
+    }
+
     if (!this->first) {
         // empty list scenario
         // nothing to remove
-        cout << "The list was already empty" << endl;
+        if constexpr (Policies::Diagnostics::enabled) {
+            cout << "The list was already empty" << endl;
+        }
+        return;
+    }
+    // one node and general scenario, unlinkNode updates first and last for both
+    // the front is the physical last node when the list is reversed
+    this->dropNode(this->head());
+
+}
+
+template <typename T, typename Policies>
+void BaseDoublyLinkedList<T, Policies>::deleteLast() {
+
+    [[maybe_unused]] auto guard = this->lockList();
+
+    while (this->tail() && isDead(this->tail())) {
+        this->dropNode(this->tail());
+    }
+
+    if (!this->first) {
+        // Error scenario: 0 nodes
+        if constexpr (Policies::Diagnostics::enabled) {
+            cout << "The list is already empty, nothing to remove" << endl;
+        }
         return;
     }
-    else if (this->first == this->last) {
-        // one node scenario
-        this->first.reset();
-        this->last.reset();
+    // One node or at least two nodes, unlinkNode handles both
+    this->dropNode(this->tail());
+}
+
+template <typename T, typename Policies>
+void BaseDoublyLinkedList<T, Policies>::reverse() {
+    [[maybe_unused]] auto guard = this->lockList();
+    reversed = !reversed;
+}
+
+template <typename T, typename Policies>
+bool BaseDoublyLinkedList<T, Policies>::isReversed() const {
+    [[maybe_unused]] auto guard = this->lockList();
+    return reversed;
+}
+
+// Closes the chain into a ring and cuts it again in front of the new head.
+// With CountNodes it walks min(k, n - k) live nodes, from whichever end is closer.  Without a count n is
+// unknown, so it walks |k| live nodes from the end k points at, and only when |k| >= n does it walk
+// the whole list once to learn n, then min(k mod n, n - k mod n) more.
+template <typename T, typename Policies>
+void BaseDoublyLinkedList<T, Policies>::rotate(const int k) {
+    [[maybe_unused]] auto guard = this->lockList();
+    // Returns the target-th live node from node on, or nullptr with seen set to the live nodes passed
+    auto walk = [this](shared_ptr<ListNode> node, const bool forwards, const long long target, long long& seen) {
+        seen = 0;
+        while (node) {
+            if (!isDead(node) && ++seen == target) {
+                return node;
+            }
+            node = forwards ? step(node) : stepBack(node);
+        }
+        return node;
+    };
+
+    long long count = 0;
+    shared_ptr<ListNode> newHead;
+    if constexpr (!Policies::Count::enabled) {
+        if (k == 0 || !first) {
+            return;
+        }
+        // Moving the first k values back makes live value k + 1 the head, moving the last -k values
+        // forward makes live value -k from the tail the head
+        if (k > 0) {
+            newHead = walk(head(), true, static_cast<long long>(k) + 1, count);
+        }
+        else {
+            newHead = walk(tail(), false, -static_cast<long long>(k), count);
+        }
     }
     else {
-        // general scenario, at least two nodes
-        this->first = this->first->next;
-        this->first->prev.reset();
+        count = this->liveNodes;
     }
 
+    if (!newHead) {
+        if (count == 0) {
+            return;
+        }
+        const long long shift = ((k % count) + count) % count;
+        if (shift == 0) {
+            return;
+        }
+        // The new head is live value number shift + 1 from the head, or number count - shift from the tail
+        long long seen = 0;
+        if (shift <= count - shift) {
+            newHead = walk(head(), true, shift + 1, seen);
+        }
+        else {
+            newHead = walk(tail(), false, count - shift, seen);
+        }
+    }
+
+    last->next = first;
+    first->prev = last;
+    if (reversed) {
+        first = newHead->next;
+        last = newHead;
+    }
+    else {
+        first = newHead;
+        last = newHead->prev;
+    }
+    first->prev.reset();
+    last->next.reset();
 }
 
-template<typename T>
-void BaseDoublyLinkedList<T>::deleteLast() {
+template <typename T, typename Policies>
+void BaseDoublyLinkedList<T, Policies>::setLazyDeletion(const bool enabled) {
+    static_assert(Policies::Delete::enabled, "Lazy deletion needs the LazyDelete policy");
+    [[maybe_unused]] auto guard = this->lockList();
+    if (!enabled) {
+        // Eager mode assumes there are no tombstones left in the chain
+        compact();
+    }
+    this->lazyDeletion = enabled;
+}
 
-    if (!this->first) {
-        // Error scenario: 0 nodes
-        cout << "The list is already empty, nothing to remove" << endl;
+template <typename T, typename Policies>
+void BaseDoublyLinkedList<T, Policies>::setCompactionRatio(const double ratio) {
+    static_assert(Policies::Delete::enabled, "Lazy deletion needs the LazyDelete policy");
+    [[maybe_unused]] auto guard = this->lockList();
+    if (ratio <= 0.0 || ratio > 1.0) {
+        throw std::invalid_argument("Compaction ratio must be in (0, 1]");
+    }
+    this->compactionRatio = ratio;
+}
+
+// Physically unlinks and frees every tombstone in a single pass
+template <typename T, typename Policies>
+void BaseDoublyLinkedList<T, Policies>::compact() {
+    if constexpr (!Policies::Delete::enabled) {
+        return;
+    }
+    [[maybe_unused]] auto guard = this->lockList();
+    shared_ptr<ListNode> currentNode{ first };
+    while (currentNode) {
+        if constexpr (Policies::Count::enabled) {
+            // Stop as soon as the last tombstone is gone
+            if (this->deadNodes == 0) {
+                break;
+            }
+        }
+        shared_ptr<ListNode> nextNode{ currentNode->next };
+        if (isDead(currentNode)) {
+            dropNode(std::move(currentNode));
+        }
+        currentNode = nextNode;
+    }
+}
+
+// Compacts once tombstones make up compactionRatio of the chain, so the pass is amortised over the deletes.
+// Without a CountPolicy there is no ratio to check, and tombstones stay until compact() is called.
+template <typename T, typename Policies>
+void BaseDoublyLinkedList<T, Policies>::compactIfNeeded() {
+    if constexpr (Policies::Count::enabled && Policies::Delete::enabled) {
+        if (this->deadNodes > 0 && this->deadNodes >= this->compactionRatio * (this->liveNodes + this->deadNodes)) {
+            compact();
+        }
+    }
+}
+
+template <typename T, typename Policies>
+unsigned int BaseDoublyLinkedList<T, Policies>::getLiveCount() const {
+    [[maybe_unused]] auto guard = this->lockList();
+    if constexpr (Policies::Count::enabled) {
+        return this->liveNodes;
+    }
+    else {
+        unsigned int count = 0;
+        for (shared_ptr<ListNode> currentNode{ first }; currentNode; currentNode = currentNode->next) {
+            if (!isDead(currentNode)) {
+                count++;
+            }
+        }
+        return count;
+    }
+}
+
+template <typename T, typename Policies>
+unsigned int BaseDoublyLinkedList<T, Policies>::getDeadCount() const {
+    [[maybe_unused]] auto guard = this->lockList();
+    if constexpr (!Policies::Delete::enabled) {
+        return 0;
+    }
+    else if constexpr (Policies::Count::enabled) {
+        return this->deadNodes;
+    }
+    else {
+        unsigned int count = 0;
+        for (shared_ptr<ListNode> currentNode{ first }; currentNode; currentNode = currentNode->next) {
+            if (isDead(currentNode)) {
+                count++;
+            }
+        }
+        return count;
+    }
+}
+
+// Returns the node holding the index-th live value, or nullptr if index is out of bounds
+template <typename T, typename Policies>
+auto BaseDoublyLinkedList<T, Policies>::findLiveNode(const unsigned int index) const -> shared_ptr<ListNode> {
+    shared_ptr<ListNode> currentNode{ head() };
+    unsigned int i = 0;
+    while (currentNode) {
+        if (!isDead(currentNode)) {
+            if (i == index) {
+                return currentNode;
+            }
+            i++;
+        }
+        currentNode = step(currentNode);
+    }
+    return nullptr;
+}
+
+template <typename T, typename Policies>
+void BaseDoublyLinkedList<T, Policies>::linkAfter(const shared_ptr<ListNode>& prior, const shared_ptr<ListNode>& node) {
+    node->prev = prior;
+    node->next = prior->next;
+    if (prior->next) {
+        prior->next->prev = node;
+    }
+    else {
+        last = node;
+    }
+    prior->next = node;
+    this->countLinked();
+}
+
+// Links node in front of next, or at the back of the list when next is nullptr
+template <typename T, typename Policies>
+void BaseDoublyLinkedList<T, Policies>::linkBefore(const shared_ptr<ListNode>& next, const shared_ptr<ListNode>& node) {
+    shared_ptr<ListNode> prior{ next ? next->prev : last };
+    if (prior) {
+        linkAfter(prior, node);
+        return;
+    }
+    // node becomes the first node
+    linkFirst(node);
+}
+
+template <typename T, typename Policies>
+void BaseDoublyLinkedList<T, Policies>::unlinkNode(shared_ptr<ListNode> node) {
+    if (node->prev) {
+        node->prev->next = node->next;
+    }
+    else {
+        first = node->next;
+    }
+    if (node->next) {
+        node->next->prev = node->prev;
+    }
+    else {
+        last = node->prev;
+    }
+    node->prev.reset();
+    node->next.reset();
+    this->countUnlinked(isDead(node));
+}
+
+// Unlinks a node that is being removed from the list, releasing its value right away, see releaseValue
+template <typename T, typename Policies>
+void BaseDoublyLinkedList<T, Policies>::dropNode(shared_ptr<ListNode> node) {
+    unlinkNode(node);
+    releaseValue(node);
+}
+
+template <typename T, typename Policies>
+void BaseDoublyLinkedList<T, Policies>::markDead(const shared_ptr<ListNode>& node) {
+    if constexpr (Policies::Delete::enabled) {
+        node->deleted = true;
+        this->countMarkedDead();
+    }
+}
+
+//Returns the live values in list order, skipping tombstones and following reverse()
+template <typename T, typename Policies>
+string BaseDoublyLinkedList<T, Policies>::getListAsString() {
+    [[maybe_unused]] auto guard = this->lockList();
+    return listAsString(!reversed);
+}
+
+//Returns the live values in the opposite of list order, skipping tombstones and following reverse()
+template <typename T, typename Policies>
+string BaseDoublyLinkedList<T, Policies>::getListBackwardsAsString() {
+    [[maybe_unused]] auto guard = this->lockList();
+    return listAsString(reversed);
+}
+
+// Dumps the live values from first to last when forwards, otherwise from last to first
+template <typename T, typename Policies>
+string BaseDoublyLinkedList<T, Policies>::listAsString(const bool forwards) const {
+    stringstream ss;
+    shared_ptr<ListNode> currentNode{ forwards ? first : last };
+    while (currentNode && isDead(currentNode)) {
+        currentNode = forwards ? currentNode->next : currentNode->prev;
+    }
+    if (!currentNode) {
+        ss << "The list is empty.";
+    }
+    else {
+
+        ss << currentNode->data;
+        currentNode = forwards ? currentNode->next : currentNode->prev;
+
+        while (currentNode) {
+            if (!isDead(currentNode)) {
+                ss << " " << currentNode->data;
+            }
+            currentNode = forwards ? currentNode->next : currentNode->prev;
+        };
+    }
+    return ss.str();
+}
+
+//Copyright 2020, Bradley Peterson, Weber State University, All rights reserved. (Oct 2021)
+//**********************************
+//Write your code below here
+//**********************************
+
+//******************
+//A positional insert or remove for DoublyLinkedList::applyBatch
+//******************
+template <typename T>
+struct ListEdit {
+    enum class Kind { Insert, Remove };
+
+    Kind kind{ Kind::Insert };
+    unsigned int index{ 0 };
+    T value{};
+
+    static ListEdit insertAt(const unsigned int index, const T& value) { return ListEdit{ Kind::Insert, index, value }; }
+    static ListEdit removeAt(const unsigned int index) { return ListEdit{ Kind::Remove, index, T{} }; }
+};
+
+template <typename T, typename Policies = ListPolicies<>>
+class DoublyLinkedList : public BaseDoublyLinkedList<T, Policies> {
+
+public:
+    typedef typename BaseDoublyLinkedList<T, Policies>::ListNode ListNode;
+
+    T get(const unsigned int index) const;
+    T& operator[](const unsigned int index) const;
+    void insert(const unsigned int index, const T& value);
+    void remove(const unsigned int index);
+    void removeAllInstances(const T& value);
+    DoublyLinkedList<T, Policies> clone() const;
+    void applyBatch(const vector<ListEdit<T>>& edits);
+private:
+
+};
+
+template <typename T, typename Policies>
+T DoublyLinkedList<T, Policies>::get(const unsigned int index) const {
+    [[maybe_unused]] auto guard = this->lockList();
+    auto temp = this->findLiveNode(index);
+    if constexpr (Policies::Check::enabled) {
+        if (!temp) {
+            throw std::out_of_range("Out of Bounds");
+        }
+    }
+    return temp->data;
+}
+
+
+template <typename T, typename Policies>
+T& DoublyLinkedList<T, Policies>::operator[](const unsigned int index) const {
+    [[maybe_unused]] auto guard = this->lockList();
+    auto temp = this->findLiveNode(index);
+    if constexpr (Policies::Check::enabled) {
+        if (!temp) {
+            throw std::out_of_range("Out of Bounds");
+        }
+    }
+    return temp->data;
+}
+
+template <typename T, typename Policies>
+void DoublyLinkedList<T, Policies>::insert(const unsigned int index, const T& value) {
+    [[maybe_unused]] auto guard = this->lockList();
+    //beginning node, also covers the empty list
+    if (index == 0) {
+        this->pushFront(value);
         return;
     }
-    else if (this->first == this->last) {
-        // One node scenario:
-        this->first.reset();
-        this->last.reset();
+    auto prior = this->findLiveNode(index - 1);
+    if constexpr (Policies::Check::enabled) {
+        if (!prior) {
+            throw std::out_of_range("Out of Bounds");
+        }
+    }
+    auto temp = this->newNode();
+    temp->data = value;
+    if (this->reversed) {
+        this->linkBefore(prior, temp);
     }
     else {
-        // At least two nodes
-        this->last = this->last->prev;
-        this->last->next.reset();
+        this->linkAfter(prior, temp);
+    }
+}
+
+template <typename T, typename Policies>
+void DoublyLinkedList<T, Policies>::remove(const unsigned int index){
+    [[maybe_unused]] auto guard = this->lockList();
+    auto temp = this->findLiveNode(index);
+    //out of bounds or empty list, nothing to remove
+    if (!temp) {
+        return;
+    }
+    if (this->lazyMode()) {
+        this->markDead(temp);
+        this->compactIfNeeded();
+    }
+    else {
+        this->dropNode(std::move(temp));
+    }
+}
+
+// Applies edits as if insert/remove were called on each of them in order, but walks the list only once.
+// Planning needs the live size up front, so without CountNodes getLiveCount() costs one more walk first.
+// Every index refers to the list as left by the edits before it.  A remove past the end is ignored like
+// remove() does.  With CheckBounds an insert past the end throws before anything is changed, without it
+// the index must be in range, as for insert().  In lazy deletion mode the result has the same tombstones
+// the single edits would have left, including the compactions their removes would have triggered.
+template <typename T, typename Policies>
+void DoublyLinkedList<T, Policies>::applyBatch(const vector<ListEdit<T>>& edits) {
+    [[maybe_unused]] auto guard = this->lockList();
+
+    // First plan the final list in position order, as pieces that are either a run of original
+    // values or a single inserted value.  Removed values stay in the plan as pieces stamped with
+    // the number of the edit that removed them.  This costs O(k^2) for k edits, no walking.
+    struct Piece {
+        unsigned int length;
+        const T* value;     // nullptr for a run of original values
+        size_t removedBy;   // 0 while the piece is live
+    };
+    vector<Piece> pieces;
+    unsigned int total = this->getLiveCount();
+    if (total > 0) {
+        pieces.push_back(Piece{ total, nullptr, 0 });
+    }
+
+    // Removes up to and including this edit are unlinked, later ones only leave tombstones.
+    // Outside lazy mode every remove unlinks, in lazy mode only those a compaction would have swept up.
+    size_t unlinkThrough = this->lazyMode() ? 0 : edits.size();
+    unsigned int dead = 0;
+    if constexpr (Policies::Count::enabled) {
+        dead = this->deadNodes;
+    }
+
+    for (size_t e = 0; e < edits.size(); e++) {
+        const ListEdit<T>& edit = edits[e];
+        if constexpr (Policies::Check::enabled) {
+            if (edit.kind == ListEdit<T>::Kind::Insert && edit.index > total) {
+                throw std::out_of_range("Out of Bounds");
+            }
+        }
+        if (edit.kind == ListEdit<T>::Kind::Remove && edit.index >= total) {
+            continue;
+        }
+
+        // Find the live piece holding edit.index, offset is the position of its first value
+        size_t p = 0;
+        unsigned int offset = 0;
+        while (p < pieces.size() && (pieces[p].removedBy != 0 || offset + pieces[p].length <= edit.index)) {
+            if (pieces[p].removedBy == 0) {
+                offset += pieces[p].length;
+            }
+            p++;
+        }
+        unsigned int k = edit.index - offset;
+
+        if (edit.kind == ListEdit<T>::Kind::Insert) {
+            if (k > 0) {
+                // Only original runs are longer than one, split it around the new value
+                Piece tail{ pieces[p].length - k, nullptr, 0 };
+                pieces[p].length = k;
+                pieces.insert(pieces.begin() + p + 1, tail);
+                p++;
+            }
+            pieces.insert(pieces.begin() + p, Piece{ 1, &edit.value, 0 });
+            total++;
+        }
+        else {
+            if (pieces[p].length > 1) {
+                // Split the run so the removed value gets a piece of its own
+                const unsigned int after = pieces[p].length - k - 1;
+                pieces[p].length = 1;
+                if (after > 0) {
+                    pieces.insert(pieces.begin() + p + 1, Piece{ after, nullptr, 0 });
+                }
+                if (k > 0) {
+                    pieces.insert(pieces.begin() + p, Piece{ k, nullptr, 0 });
+                    p++;
+                }
+            }
+            pieces[p].removedBy = e + 1;
+            total--;
+
+            // Follow the counts remove() would see, to find the last remove that compacts
+            if constexpr (Policies::Count::enabled && Policies::Delete::enabled) {
+                dead++;
+                if (this->lazyMode() && dead >= this->compactionRatio * (total + dead)) {
+                    dead = 0;
+                    unlinkThrough = e + 1;
+                }
+            }
+        }
+    }
+
+    // Tombstones from before the batch were swept up by the first compaction
+    if (this->lazyMode() && unlinkThrough > 0) {
+        this->compact();
+    }
+
+    // Then apply the plan in one sweep over the original live nodes, in the direction of the list
+    auto skipDead = [this](shared_ptr<ListNode> node) {
+        while (node && this->isDead(node)) {
+            node = this->step(node);
+        }
+        return node;
+    };
+    shared_ptr<ListNode> currentNode{ skipDead(this->head()) };
+    for (const Piece& piece : pieces) {
+        const bool unlinked = piece.removedBy != 0 && piece.removedBy <= unlinkThrough;
+        if (piece.value) {
+            if (unlinked) {
+                continue;
+            }
+            auto temp = this->newNode();
+            temp->data = *piece.value;
+            if (!this->reversed) {
+                this->linkBefore(currentNode, temp);
+            }
+            else if (currentNode) {
+                this->linkAfter(currentNode, temp);
+            }
+            else {
+                this->linkFirst(temp);
+            }
+            if (piece.removedBy != 0) {
+                this->markDead(temp);
+            }
+        }
+        else if (piece.removedBy != 0) {
+            auto nextNode = skipDead(this->step(currentNode));
+            if (unlinked) {
+                this->dropNode(std::move(currentNode));
+            }
+            else {
+                this->markDead(currentNode);
+            }
+            currentNode = nextNode;
+        }
+        else {
+            for (unsigned int i = 0; i < piece.length; i++) {
+                currentNode = skipDead(this->step(currentNode));
+            }
+        }
     }
 }
 
-//This method helps return a string representation of all nodes in the linked list, do not modify.
-template <typename T>
-string BaseDoublyLinkedList<T>::getListAsString() {
-    stringstream ss;
-    if (!first) {
-        ss << "The list is empty.";
-    }
-    else {
-
-        shared_ptr<Node<T>> currentNode{ first };
-        ss << currentNode->data;
-        currentNode = currentNode->next;
-
-        while (currentNode) {
-            ss << " " << currentNode->data;
-            currentNode = currentNode->next;
-        };
-    }
-    return ss.str();
+// Deep copy, see BaseDoublyLinkedList::copyFrom
+template <typename T, typename Policies>
+DoublyLinkedList<T, Policies> DoublyLinkedList<T, Policies>::clone() const {
+    return DoublyLinkedList<T, Policies>(*this);
 }
 
-//This method helps return a string representation of all nodes in the linked list, do not modify.
-template <typename T>
-string BaseDoublyLinkedList<T>::getListBackwardsAsString() {
-    stringstream ss;
-    if (!first) {
-        ss << "The list is empty.";
+template <typename T, typename Policies>
+void DoublyLinkedList<T, Policies>::removeAllInstances(const T& value) {
+    [[maybe_unused]] auto guard = this->lockList();
+    auto temp = this->first;
+    while (temp) {
+        auto nextNode = temp->next;
+        if (!this->isDead(temp) && temp->data == value) {
+            if (this->lazyMode()) {
+                this->markDead(temp);
+            }
+            else {
+                this->dropNode(std::move(temp));
+            }
+        }
+        temp = nextNode;
     }
-    else {
-
-        shared_ptr<Node<T>> currentNode{ last };
-        ss << currentNode->data;
-        currentNode = currentNode->prev;
-
-        while (currentNode) {
-            ss << " " << currentNode->data;
-            currentNode = currentNode->prev;
-        };
+    if (this->lazyMode()) {
+        this->compactIfNeeded();
     }
-    return ss.str();
 }
 
-//Copyright 2020, Bradley Peterson, Weber State University, All rights reserved. (Oct 2021)
-//**********************************
-//Write your code below here
-//**********************************
-template <typename T>
-class DoublyLinkedList : public BaseDoublyLinkedList<T> {
-
+//******************
+//The LRU cache class
+//Entries are kept most recent first in a doubly linked node chain, with a hash map from key to node
+//so get, put and erase never walk the chain.  Keys are spread over shards, each with its own lock.
+//******************
+template <typename K, typename V>
+class LruCache {
 public:
-    T get(const unsigned int index) const;
-    T& operator[](const unsigned int index) const;
-    void insert(const unsigned int index, const T& value);
-    void remove(const unsigned int index);
-    void removeAllInstances(const T& value);
-private:
+    LruCache(const unsigned int capacity, const unsigned int shardCount = 1);
+    bool get(const K& key, V& value);
+    void put(const K& key, const V& value);
+    bool erase(const K& key);
+    unsigned int size() const;
+    unsigned long long getHits() const;
+    unsigned long long getMisses() const;
+    unsigned long long getEvictions() const;
 
+private:
+    typedef std::pair<K, V> Entry;
+    // The map tracks the size and the shard lock guards the list, so the list itself needs none of that
+    typedef ListPolicies<NoCount, NoBoundsCheck, NoDiagnostics> RecencyPolicies;
+
+    // Exposes the node level operations of the list that the cache needs
+    class RecencyList : public BaseDoublyLinkedList<Entry, RecencyPolicies> {
+    public:
+        shared_ptr<Node<Entry>> pushFrontNode(const Entry& entry);
+        void moveToFront(const shared_ptr<Node<Entry>>& node);
+        void unlink(const shared_ptr<Node<Entry>>& node) { this->unlinkNode(node); }
+        shared_ptr<Node<Entry>> back() const { return this->last; }
+    };
+
+    struct Shard {
+        mutable std::mutex lock;
+        RecencyList recency;
+        std::unordered_map<K, shared_ptr<Node<Entry>>> index;
+        unsigned int capacity{ 0 };
+        unsigned long long hits{ 0 };
+        unsigned long long misses{ 0 };
+        unsigned long long evictions{ 0 };
+    };
+
+    Shard& shardFor(const K& key);
+    unsigned long long sumOver(unsigned long long Shard::* counter) const;
+
+    vector<std::unique_ptr<Shard>> shards;
 };
 
-template <typename T>
-T DoublyLinkedList<T>::get(const unsigned int index) const {
-   auto temp = this->first;
-   unsigned int i = 0;
-
-   while (index != i) {
-       temp = temp->next;
-       i++;
-
-       if (!temp->next && index > i) {
-           throw std::out_of_range("Out of Bounds");
-       }
-   }
-   return temp->data;
+template <typename K, typename V>
+shared_ptr<Node<std::pair<K, V>>> LruCache<K, V>::RecencyList::pushFrontNode(const Entry& entry) {
+    this->pushFront(entry);
+    return this->first;
 }
 
-
-template <typename T>
-T& DoublyLinkedList<T>::operator[](const unsigned int index) const {
-    auto temp = this->first;
-    unsigned int i = 0;
-
-    while (index != i) {
-        temp = temp->next;
-        i++;
-
-        if (!temp->next && index > i) {
-            throw std::out_of_range("Out of Bounds");
-        }
+template <typename K, typename V>
+void LruCache<K, V>::RecencyList::moveToFront(const shared_ptr<Node<Entry>>& node) {
+    if (node == this->first) {
+        return;
     }
-    return temp->data;
+    // node isn't first, so the list still has a first node after unlinking it
+    this->unlinkNode(node);
+    node->next = this->first;
+    this->first->prev = node;
+    this->first = node;
+    this->countLinked();
 }
 
-template<typename T>
-void DoublyLinkedList<T>::insert(const unsigned int index, const T& value) {
-    auto prior = this->first;
-    auto curr = this->first;
-    auto temp = make_shared<Node<T>>();
-    temp->data = value;
-    unsigned int i = 0;
-    while (index != i + 1) {
-        if (index == 0) {
-            break;
-        }
-        curr = prior->next;
-        prior = curr;
-        curr = curr->next;
-        i++;
-    }
-    //one node
-    if (index == i && this->first == this->last) {
-        this->first = temp;
-        this->last = temp;
-    }
-    //two node
-    else if (this->first == this->last && index != 0) {
-        prior->next = temp;
-        temp->prev = prior;
-        this->last = temp;
-        this->first = this->last->prev;
-    }
-    //beginning node
-    else if (index == i) {
-        temp->next = prior;
-        temp->prev = prior->prev;
-        prior->prev = temp;
-        this->first = temp;
-    }
-    //ending node
-    else if (!curr && prior) {
-        prior->next = temp;
-        temp->prev = prior;
-        temp->next.reset();
-        this->last = temp;
-    }
-    //general
-    else {
-        temp->next = curr;
-        temp->prev = prior;
-        prior->next = temp;
-        curr->prev = temp;
+template <typename K, typename V>
+LruCache<K, V>::LruCache(const unsigned int capacity, const unsigned int shardCount) {
+    if (capacity == 0 || shardCount == 0) {
+        throw std::invalid_argument("LruCache needs a capacity and at least one shard");
+    }
+    // Every shard must hold at least one entry, so there are never more shards than entries
+    const unsigned int usedShards = shardCount < capacity ? shardCount : capacity;
+    for (unsigned int i = 0; i < usedShards; i++) {
+        shards.push_back(std::make_unique<Shard>());
+        // Spread the capacity as evenly as possible, the first shards take the remainder
+        shards.back()->capacity = capacity / usedShards + (i < capacity % usedShards ? 1 : 0);
     }
 }
 
-template<typename T>
-void DoublyLinkedList<T>::remove(const unsigned int index){
-    auto temp = this->first;
-    unsigned int i = 0;
-    while (index != i) {
-        temp = temp->next;
-        i++;
-        if (index > i && !temp) {
-            break;
-        }
-    }
-    //beginning node
-    if (index == 0) {
-        //empty list
-        if (this->first == this->last) {
-            this->first.reset();
-            this->last.reset();
-        }
-        else {
-            this->first = temp->next;
-            temp->next->prev = nullptr;
-        }
+template <typename K, typename V>
+typename LruCache<K, V>::Shard& LruCache<K, V>::shardFor(const K& key) {
+    if (shards.size() == 1) {
+        return *shards[0];
     }
-    //one node 
-    else if (index == i && this->first == this->last) {
-        temp = this->first;
-    }
-    //ending node
-    else if (temp == this->last) {
-        this->last = temp->prev;
-        this->last->next.reset();
+    return *shards[std::hash<K>{}(key) % shards.size()];
+}
+
+// Looks up key, on a hit copies its value into value and makes it the most recently used entry
+template <typename K, typename V>
+bool LruCache<K, V>::get(const K& key, V& value) {
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    auto found = shard.index.find(key);
+    if (found == shard.index.end()) {
+        shard.misses++;
+        return false;
     }
-    //out of bounds 
-    else if (index > i) {
-        temp = this->first;
+    shard.hits++;
+    shard.recency.moveToFront(found->second);
+    value = found->second->data.second;
+    return true;
+}
+
+// Inserts or updates key as the most recently used entry, evicting the least recently used one when full
+template <typename K, typename V>
+void LruCache<K, V>::put(const K& key, const V& value) {
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    auto found = shard.index.find(key);
+    if (found != shard.index.end()) {
+        found->second->data.second = value;
+        shard.recency.moveToFront(found->second);
+        return;
     }
-    //general
-    else {
-        temp->prev->next = temp->next;
-        temp->next->prev = temp->prev;
+    if (shard.index.size() >= shard.capacity) {
+        shared_ptr<Node<Entry>> victim = shard.recency.back();
+        shard.index.erase(victim->data.first);
+        shard.recency.unlink(victim);
+        shard.evictions++;
     }
+    shard.index.emplace(key, shard.recency.pushFrontNode(Entry(key, value)));
 }
 
-template<typename T>
-void DoublyLinkedList<T>::removeAllInstances(const T& value) {
-    auto temp = this->first;
-    unsigned int i = 0;
-    //empty list
-    if (!temp) {
-        return;
+template <typename K, typename V>
+bool LruCache<K, V>::erase(const K& key) {
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    auto found = shard.index.find(key);
+    if (found == shard.index.end()) {
+        return false;
     }
-    //one node
-    else if (!temp->prev && !temp->next) {
-            this->first.reset();
-            this->last.reset();
+    shard.recency.unlink(found->second);
+    shard.index.erase(found);
+    return true;
+}
+
+template <typename K, typename V>
+unsigned int LruCache<K, V>::size() const {
+    unsigned int total = 0;
+    for (const auto& shard : shards) {
+        std::lock_guard<std::mutex> guard(shard->lock);
+        total += static_cast<unsigned int>(shard->index.size());
     }
-    while (temp->next) {
-        //removes value after first node
-        if (temp == this->first && this->first->data != value && temp->next->data == value) {
-            temp = temp->next;
-            temp->prev->next = temp->next;
-            temp->next->prev = temp->prev;
-            temp = this->first;
-        }
-        else {
-            //move temp to the next
-            temp = temp->next;
-            i++;
-        }
-        //beginning has value to remove
-        if (this->first->data == value) {
-            //temp->prev = temp->next;
-            temp->next = temp->next;
-            temp->prev.reset();
-            this->first = temp;
-        }
-        //ending
-        else if (this->last->data == value) {
-            //removes multiple at the end
-            if (this->last->prev->data == value) {
-                this->last = this->last->prev;
-                this->last->next.reset();
-            }
-            //removes one at the end
-            if (this->last->prev->data != value) {
-                this->last = this->last->prev;
-                this->last->next.reset();
-            }
-        }
-        //general
-        else if (temp->data == value) {
-            temp->prev->next = temp->next;
-            temp->next->prev = temp->prev;
-        }
+    return total;
+}
+
+template <typename K, typename V>
+unsigned long long LruCache<K, V>::sumOver(unsigned long long Shard::* counter) const {
+    unsigned long long total = 0;
+    for (const auto& shard : shards) {
+        std::lock_guard<std::mutex> guard(shard->lock);
+        total += (*shard).*counter;
     }
+    return total;
+}
+
+template <typename K, typename V>
+unsigned long long LruCache<K, V>::getHits() const {
+    return sumOver(&Shard::hits);
+}
+
+template <typename K, typename V>
+unsigned long long LruCache<K, V>::getMisses() const {
+    return sumOver(&Shard::misses);
+}
+
+template <typename K, typename V>
+unsigned long long LruCache<K, V>::getEvictions() const {
+    return sumOver(&Shard::evictions);
 }
 
 
@@ -782,6 +1940,767 @@ void testRemoveAllInstances() {
 
 }
 
+void testLazyDeletion() {
+    DoublyLinkedList<int, LazyDeletePolicies> d;
+    for (int i = 10; i < 20; i++) {
+        d.pushBack(i);
+    }
+    d.setLazyDeletion(true);
+    d.setCompactionRatio(0.5);
+
+    //Removes only leave tombstones behind
+    d.remove(2);
+    checkTest("testLazyDeletion #1", "10 11 13 14 15 16 17 18 19", d.getListAsString());
+    checkTest("testLazyDeletion #2", "19 18 17 16 15 14 13 11 10", d.getListBackwardsAsString());
+    checkTest("testLazyDeletion #3", 9, d.getLiveCount());
+    checkTest("testLazyDeletion #4", 1, d.getDeadCount());
+
+    //Indexing skips the tombstones
+    checkTest("testLazyDeletion #5", 13, d.get(2));
+    d[2] = 1300;
+    checkTest("testLazyDeletion #6", "10 11 1300 14 15 16 17 18 19", d.getListAsString());
+
+    d.removeAllInstances(15);
+    d.insert(2, 12);
+    checkTest("testLazyDeletion #7", "10 11 12 1300 14 16 17 18 19", d.getListAsString());
+    checkTest("testLazyDeletion #8", "19 18 17 16 14 1300 12 11 10", d.getListBackwardsAsString());
+    checkTest("testLazyDeletion #9", 2, d.getDeadCount());
+
+    //Tombstones at the ends are dropped by deleteFirst/deleteLast
+    d.remove(0);
+    d.deleteFirst();
+    checkTest("testLazyDeletion #10", "12 1300 14 16 17 18 19", d.getListAsString());
+    checkTest("testLazyDeletion #11", 2, d.getDeadCount());
+
+    //Explicit compaction
+    d.compact();
+    checkTest("testLazyDeletion #12", 0, d.getDeadCount());
+    checkTest("testLazyDeletion #13", 7, d.getLiveCount());
+    checkTest("testLazyDeletion #14", "19 18 17 16 14 1300 12", d.getListBackwardsAsString());
+
+    //Compaction triggers once half the nodes are tombstones
+    d.remove(0);
+    d.remove(0);
+    d.remove(0);
+    checkTest("testLazyDeletion #15", 3, d.getDeadCount());
+    d.remove(0);
+    checkTest("testLazyDeletion #16", 0, d.getDeadCount());
+    checkTest("testLazyDeletion #17", "17 18 19", d.getListAsString());
+    checkTest("testLazyDeletion #18", "19 18 17", d.getListBackwardsAsString());
+
+    string caughtError = "";
+    try {
+        d.get(3);
+    }
+    catch (std::out_of_range & oor) {
+        caughtError = "caught";
+    }
+    checkTest("testLazyDeletion #19", "caught", caughtError);
+
+    d.removeAllInstances(18);
+    d.setLazyDeletion(false);
+    checkTest("testLazyDeletion #20", 0, d.getDeadCount());
+    checkTest("testLazyDeletion #21", "17 19", d.getListAsString());
+    d.remove(1);
+    d.remove(0);
+    checkTest("testLazyDeletion #22", "The list is empty.", d.getListAsString());
+    checkTest("testLazyDeletion #23", 0, d.getLiveCount());
+}
+
+void testCopy() {
+    DoublyLinkedList<int, LazyDeletePolicies> d;
+    for (int i = 10; i < 15; i++) {
+        d.pushBack(i);
+    }
+
+    //The copy must not share nodes with the original
+    DoublyLinkedList<int, LazyDeletePolicies> copy(d);
+    d[0] = 100;
+    d.remove(2);
+    copy.pushBack(15);
+    checkTest("testCopy #1", "100 11 13 14", d.getListAsString());
+    checkTest("testCopy #2", "10 11 12 13 14 15", copy.getListAsString());
+    checkTest("testCopy #3", "15 14 13 12 11 10", copy.getListBackwardsAsString());
+    checkTest("testCopy #4", 6, copy.getLiveCount());
+
+    //Edits on block allocated nodes
+    copy.remove(2);
+    copy.insert(2, 22);
+    copy.deleteFirst();
+    copy.deleteLast();
+    checkTest("testCopy #5", "11 22 13 14", copy.getListAsString());
+    checkTest("testCopy #6", "14 13 22 11", copy.getListBackwardsAsString());
+
+    //Assignment replaces the old contents, tombstones are not copied
+    d.setLazyDeletion(true);
+    d.remove(1);
+    copy = d;
+    checkTest("testCopy #7", "100 13 14", copy.getListAsString());
+    checkTest("testCopy #8", "14 13 100", copy.getListBackwardsAsString());
+    checkTest("testCopy #9", 0, copy.getDeadCount());
+    checkTest("testCopy #10", 1, d.getDeadCount());
+
+    DoublyLinkedList<int, LazyDeletePolicies> empty;
+    copy = empty.clone();
+    checkTest("testCopy #11", "The list is empty.", copy.getListAsString());
+    copy.pushFront(1);
+    checkTest("testCopy #12", "1", copy.getListBackwardsAsString());
+
+    //Values that are not trivially copyable
+    DoublyLinkedList<string> words;
+    words.pushBack("alpha");
+    words.pushBack("beta");
+    words.pushBack("gamma");
+    DoublyLinkedList<string> wordsCopy = words.clone();
+    words[1] = "delta";
+    checkTest("testCopy #13", "alpha beta gamma", wordsCopy.getListAsString());
+    checkTest("testCopy #14", "alpha delta gamma", words.getListAsString());
+
+    //Copying a large list
+    DoublyLinkedList<int> big;
+    for (int i = 0; i < 100000; i++) {
+        big.pushBack(i);
+    }
+    auto start = std::chrono::high_resolution_clock::now();
+    DoublyLinkedList<int> bigCopy = big.clone();
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::micro> diff = end - start;
+    cout << "    Copying 100,000 numbers took " << (diff.count() / 1000.0) << " milliseconds." << endl;
+    checkTest("testCopy #15", 99999, bigCopy.get(99999));
+    checkTest("testCopy #16", 100000, bigCopy.getLiveCount());
+
+    //Values removed from a copy are destroyed right away, use_count counts the copies of token still alive
+    shared_ptr<int> token = make_shared<int>(7);
+    DoublyLinkedList<shared_ptr<int>> tokens;
+    for (int i = 0; i < 5; i++) {
+        tokens.pushBack(token);
+    }
+    DoublyLinkedList<shared_ptr<int>> tokensCopy = tokens.clone();
+    checkTest("testCopy #17", 11, static_cast<int>(token.use_count()));
+    for (int i = 0; i < 4; i++) {
+        tokensCopy.remove(0);
+    }
+    checkTest("testCopy #18", 7, static_cast<int>(token.use_count()));
+    tokensCopy = tokens.clone();
+    tokensCopy.deleteFirst();
+    tokensCopy.deleteLast();
+    checkTest("testCopy #19", 9, static_cast<int>(token.use_count()));
+    tokensCopy.removeAllInstances(token);
+    checkTest("testCopy #20", 6, static_cast<int>(token.use_count()));
+}
+
+void testLruCache() {
+    LruCache<int, string> cache(3);
+    string value = "";
+
+    cache.put(1, "one");
+    cache.put(2, "two");
+    cache.put(3, "three");
+    checkTest("testLruCache #1", 3, cache.size());
+
+    //A hit makes 1 the most recently used, so 2 is the one evicted
+    checkTest("testLruCache #2", true, cache.get(1, value));
+    checkTest("testLruCache #3", "one", value);
+    cache.put(4, "four");
+    checkTest("testLruCache #4", false, cache.get(2, value));
+    checkTest("testLruCache #5", 1, cache.getEvictions());
+
+    //Updating an entry also makes it the most recently used
+    cache.put(3, "THREE");
+    cache.put(5, "five");
+    checkTest("testLruCache #6", false, cache.get(1, value));
+    checkTest("testLruCache #7", true, cache.get(3, value));
+    checkTest("testLruCache #8", "THREE", value);
+
+    checkTest("testLruCache #9", true, cache.erase(4));
+    checkTest("testLruCache #10", false, cache.erase(4));
+    checkTest("testLruCache #11", 2, cache.size());
+    checkTest("testLruCache #12", 2, cache.getHits());
+    checkTest("testLruCache #13", 2, cache.getMisses());
+    checkTest("testLruCache #14", 2, cache.getEvictions());
+
+    //The last entry can be erased and re-added
+    cache.erase(3);
+    cache.erase(5);
+    checkTest("testLruCache #15", 0, cache.size());
+    cache.put(6, "six");
+    checkTest("testLruCache #16", true, cache.get(6, value));
+
+    //Sharded cache keeps its total capacity
+    LruCache<int, int> sharded(100, 4);
+    for (int i = 0; i < 1000; i++) {
+        sharded.put(i, i * 2);
+    }
+    int number = 0;
+    checkTest("testLruCache #17", true, sharded.size() <= 100);
+    checkTest("testLruCache #18", true, sharded.get(999, number));
+    checkTest("testLruCache #19", 1998, number);
+
+    //Capacity that doesn't divide evenly over the shards, and fewer entries than shards
+    LruCache<int, int> uneven(10, 4);
+    LruCache<int, int> tiny(3, 16);
+    for (int i = 0; i < 1000; i++) {
+        uneven.put(i, i);
+        tiny.put(i, i);
+    }
+    checkTest("testLruCache #20", 10, uneven.size());
+    checkTest("testLruCache #21", 3, tiny.size());
+
+    //Throughput, a mix of gets and puts over a key space twice the capacity
+    const int operations = 1000000;
+    LruCache<int, int> single(10000);
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < operations; i++) {
+        int key = static_cast<int>((i * 7919LL) % 20000);
+        if (!single.get(key, number)) {
+            single.put(key, i);
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::micro> diff = end - start;
+    cout << "    1,000,000 LruCache operations on one thread took " << (diff.count() / 1000.0) << " milliseconds ("
+        << (operations / diff.count()) << " million ops per second)." << endl;
+
+    const int threadCount = 4;
+    LruCache<int, int> shared(10000, 16);
+    vector<std::thread> threads;
+    start = std::chrono::high_resolution_clock::now();
+    for (int t = 0; t < threadCount; t++) {
+        threads.emplace_back([&shared, t, operations, threadCount]() {
+            int threadNumber = 0;
+            for (int i = t; i < operations; i += threadCount) {
+                int key = static_cast<int>((i * 7919LL) % 20000);
+                if (!shared.get(key, threadNumber)) {
+                    shared.put(key, i);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    end = std::chrono::high_resolution_clock::now();
+    diff = end - start;
+    cout << "    1,000,000 LruCache operations on " << threadCount << " threads with 16 shards took " << (diff.count() / 1000.0)
+        << " milliseconds (" << (operations / diff.count()) << " million ops per second)." << endl;
+    checkTest("testLruCache #22", operations, static_cast<int>(shared.getHits() + shared.getMisses()));
+}
+
+void testApplyBatch() {
+    DoublyLinkedList<int> d;
+    for (int i = 10; i < 20; i++) {
+        d.pushBack(i);
+    }
+
+    //Indexes refer to the list as left by the earlier edits
+    vector<ListEdit<int>> edits;
+    edits.push_back(ListEdit<int>::insertAt(3, 33));
+    edits.push_back(ListEdit<int>::removeAt(0));
+    edits.push_back(ListEdit<int>::insertAt(10, 20));
+    edits.push_back(ListEdit<int>::removeAt(2));
+    edits.push_back(ListEdit<int>::insertAt(0, 9));
+    edits.push_back(ListEdit<int>::removeAt(500));
+    d.applyBatch(edits);
+    checkTest("testApplyBatch #1", "9 11 12 13 14 15 16 17 18 19 20", d.getListAsString());
+    checkTest("testApplyBatch #2", "20 19 18 17 16 15 14 13 12 11 9", d.getListBackwardsAsString());
+    checkTest("testApplyBatch #3", 11, d.getLiveCount());
+
+    //An insert out of bounds leaves the list untouched
+    edits.clear();
+    edits.push_back(ListEdit<int>::removeAt(0));
+    edits.push_back(ListEdit<int>::insertAt(11, 0));
+    string caughtError = "";
+    try {
+        d.applyBatch(edits);
+    }
+    catch (std::out_of_range & oor) {
+        caughtError = "caught";
+    }
+    checkTest("testApplyBatch #4", "caught", caughtError);
+    checkTest("testApplyBatch #5", "9 11 12 13 14 15 16 17 18 19 20", d.getListAsString());
+
+    //Starting from an empty list, and emptying it again
+    DoublyLinkedList<int> empty;
+    edits.clear();
+    edits.push_back(ListEdit<int>::insertAt(0, 2));
+    edits.push_back(ListEdit<int>::insertAt(0, 1));
+    edits.push_back(ListEdit<int>::insertAt(2, 3));
+    empty.applyBatch(edits);
+    checkTest("testApplyBatch #6", "1 2 3", empty.getListAsString());
+    edits.clear();
+    edits.push_back(ListEdit<int>::removeAt(1));
+    edits.push_back(ListEdit<int>::removeAt(0));
+    edits.push_back(ListEdit<int>::removeAt(0));
+    empty.applyBatch(edits);
+    checkTest("testApplyBatch #7", "The list is empty.", empty.getListAsString());
+
+    //Random batches must match applying the edits one at a time, tombstones included
+    std::mt19937 random(2021);
+    bool allMatched = true;
+    for (int round = 0; round < 50; round++) {
+        //Built the same way rather than copied, as a copy drops the tombstones
+        DoublyLinkedList<int, LazyDeletePolicies> batched;
+        DoublyLinkedList<int, LazyDeletePolicies> sequential;
+        for (DoublyLinkedList<int, LazyDeletePolicies>* list : { &batched, &sequential }) {
+            for (int i = 0; i < 40; i++) {
+                list->pushBack(i);
+            }
+            list->setLazyDeletion(round % 2 == 0);
+            list->setCompactionRatio(round % 4 == 0 ? 0.2 : 0.5);
+            list->remove(5);
+        }
+
+        edits.clear();
+        unsigned int size = batched.getLiveCount();
+        for (int i = 0; i < 30; i++) {
+            if (random() % 2 == 0) {
+                edits.push_back(ListEdit<int>::insertAt(random() % (size + 1), 100 + i));
+                sequential.insert(edits.back().index, edits.back().value);
+                size++;
+            }
+            else {
+                edits.push_back(ListEdit<int>::removeAt(random() % (size + 2)));
+                sequential.remove(edits.back().index);
+                size = sequential.getLiveCount();
+            }
+        }
+        batched.applyBatch(edits);
+        if (batched.getListAsString() != sequential.getListAsString()
+            || batched.getListBackwardsAsString() != sequential.getListBackwardsAsString()
+            || batched.getLiveCount() != sequential.getLiveCount()
+            || batched.getDeadCount() != sequential.getDeadCount()) {
+            allMatched = false;
+        }
+    }
+    checkTest("testApplyBatch #8", true, allMatched);
+
+    //Timing against applying the edits one at a time on a long list
+    DoublyLinkedList<int> big;
+    for (int i = 0; i < 100000; i++) {
+        big.pushBack(i);
+    }
+    DoublyLinkedList<int> bigSequential(big);
+    edits.clear();
+    for (int i = 0; i < 500; i++) {
+        if (i % 2 == 0) {
+            edits.push_back(ListEdit<int>::insertAt(random() % 100000, i));
+        }
+        else {
+            edits.push_back(ListEdit<int>::removeAt(random() % 100000));
+        }
+    }
+    auto start = std::chrono::high_resolution_clock::now();
+    for (const ListEdit<int>& edit : edits) {
+        if (edit.kind == ListEdit<int>::Kind::Insert) {
+            bigSequential.insert(edit.index, edit.value);
+        }
+        else {
+            bigSequential.remove(edit.index);
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::micro> diff = end - start;
+    cout << "    500 edits one at a time took " << (diff.count() / 1000.0) << " milliseconds." << endl;
+    start = std::chrono::high_resolution_clock::now();
+    big.applyBatch(edits);
+    end = std::chrono::high_resolution_clock::now();
+    diff = end - start;
+    cout << "    500 edits with applyBatch took " << (diff.count() / 1000.0) << " milliseconds." << endl;
+    checkTest("testApplyBatch #9", bigSequential.getListAsString(), big.getListAsString());
+}
+
+//Counts every allocation made through any rebound copy of it
+int countingAllocations = 0;
+
+template <typename T>
+struct CountingAllocator {
+    typedef T value_type;
+
+    CountingAllocator() = default;
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&) {}
+
+    T* allocate(const size_t count) {
+        countingAllocations++;
+        return std::allocator<T>().allocate(count);
+    }
+    void deallocate(T* pointer, const size_t count) { std::allocator<T>().deallocate(pointer, count); }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const CountingAllocator<U>&) const { return false; }
+};
+
+void testPolicies() {
+    typedef ListPolicies<NoCount, NoBoundsCheck, NoDiagnostics> LeanPolicies;
+    typedef ListPolicies<NoCount, NoBoundsCheck, NoDiagnostics, MakeSharedAlloc, SingleThreaded, LazyDelete> LeanLazyPolicies;
+    typedef ListPolicies<CountNodes, CheckBounds, PrintDiagnostics, MakeSharedAlloc, MutexLocked> LockedPolicies;
+
+    //Disabled policies take no storage, a list holds its two ends, its direction and the counts if it keeps them
+    struct LeanLayout {
+        shared_ptr<Node<int>> first;
+        shared_ptr<Node<int>> last;
+        bool reversed;
+    };
+    struct CountedLayout {
+        unsigned int liveNodes;
+        unsigned int deadNodes;
+        shared_ptr<Node<int>> first;
+        shared_ptr<Node<int>> last;
+        bool reversed;
+    };
+    static_assert(sizeof(DoublyLinkedList<int, LeanPolicies>) == sizeof(LeanLayout), "testPolicies #1");
+    static_assert(sizeof(DoublyLinkedList<int>) == sizeof(CountedLayout), "testPolicies #2");
+
+    DoublyLinkedList<int, LeanLazyPolicies> lean;
+    for (int i = 10; i < 20; i++) {
+        lean.pushBack(i);
+    }
+    lean.insert(3, 33);
+    lean.remove(0);
+    lean.removeAllInstances(15);
+    checkTest("testPolicies #3", "11 12 33 13 14 16 17 18 19", lean.getListAsString());
+    checkTest("testPolicies #4", "19 18 17 16 14 13 33 12 11", lean.getListBackwardsAsString());
+    checkTest("testPolicies #5", 33, lean.get(2));
+
+    //Without a count the counters walk the list, and tombstones stay until compact()
+    checkTest("testPolicies #6", 9, lean.getLiveCount());
+    lean.setLazyDeletion(true);
+    lean.remove(0);
+    lean.remove(0);
+    lean.remove(0);
+    lean.remove(0);
+    lean.remove(0);
+    checkTest("testPolicies #7", 5, lean.getDeadCount());
+    checkTest("testPolicies #8", "16 17 18 19", lean.getListAsString());
+    lean.compact();
+    checkTest("testPolicies #9", 0, lean.getDeadCount());
+    checkTest("testPolicies #10", "19 18 17 16", lean.getListBackwardsAsString());
+
+    //Copies and moves
+    DoublyLinkedList<int, LeanLazyPolicies> leanCopy = lean.clone();
+    lean.deleteFirst();
+    checkTest("testPolicies #11", "16 17 18 19", leanCopy.getListAsString());
+    DoublyLinkedList<int, LeanLazyPolicies> leanMoved(std::move(leanCopy));
+    checkTest("testPolicies #12", "16 17 18 19", leanMoved.getListAsString());
+    checkTest("testPolicies #13", "The list is empty.", leanCopy.getListAsString());
+
+    //No diagnostics printed when deleting from an empty list
+    stringstream captured;
+    std::streambuf* original = cout.rdbuf(captured.rdbuf());
+    leanCopy.deleteFirst();
+    leanCopy.deleteLast();
+    cout.rdbuf(original);
+    checkTest("testPolicies #14", "", captured.str());
+
+    //Nodes created through an allocator
+    DoublyLinkedList<int, ListPolicies<CountNodes, CheckBounds, PrintDiagnostics, AllocateSharedWith<std::allocator<int>>>> allocated;
+    allocated.pushBack(2);
+    allocated.pushFront(1);
+    allocated.insert(2, 3);
+    checkTest("testPolicies #15", "1 2 3", allocated.getListAsString());
+
+    //Copies build their node block through the allocator as well
+    DoublyLinkedList<int, ListPolicies<CountNodes, CheckBounds, PrintDiagnostics, AllocateSharedWith<CountingAllocator<int>>>> counted;
+    for (int i = 0; i < 10; i++) {
+        counted.pushBack(i);
+    }
+    checkTest("testPolicies #16", 10, countingAllocations);
+    auto countedCopy = counted.clone();
+    checkTest("testPolicies #17", true, countingAllocations > 10);
+    checkTest("testPolicies #18", "0 1 2 3 4 5 6 7 8 9", countedCopy.getListAsString());
+
+    //A locked list shared by several threads
+    DoublyLinkedList<int, LockedPolicies> locked;
+    vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&locked, t]() {
+            for (int i = 0; i < 1000; i++) {
+                if (i % 2 == 0) {
+                    locked.pushBack(t);
+                }
+                else {
+                    locked.insert(0, t);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    checkTest("testPolicies #19", 4000, locked.getLiveCount());
+    locked.removeAllInstances(0);
+    checkTest("testPolicies #20", 3000, locked.getLiveCount());
+    DoublyLinkedList<int, LockedPolicies> lockedCopy(locked);
+    checkTest("testPolicies #21", 3000, lockedCopy.getLiveCount());
+
+    //Moves between two locked lists in both directions at once hold both locks and never deadlock
+    DoublyLinkedList<int, LockedPolicies> left;
+    DoublyLinkedList<int, LockedPolicies> right;
+    std::thread toRight([&left, &right]() {
+        for (int i = 0; i < 1000; i++) {
+            left.pushBack(1);
+            right = std::move(left);
+        }
+    });
+    std::thread toLeft([&left, &right]() {
+        for (int i = 0; i < 1000; i++) {
+            right.pushBack(2);
+            left = std::move(right);
+        }
+    });
+    toRight.join();
+    toLeft.join();
+    //A torn move would leave a count that doesn't match the nodes
+    left.removeAllInstances(1);
+    left.removeAllInstances(2);
+    right.removeAllInstances(1);
+    right.removeAllInstances(2);
+    checkTest("testPolicies #24", 0, left.getLiveCount() + right.getLiveCount());
+
+    //Only lazy deletion lists pay for the tombstone flag
+    checkTest("testPolicies #22", true, sizeof(Node<int>) < sizeof(Node<int, true>));
+    checkTest("testPolicies #23", 0, DoublyLinkedList<int>().getDeadCount());
+}
+
+void testReverseAndRotate() {
+    DoublyLinkedList<int, LazyDeletePolicies> d;
+    for (int i = 10; i < 16; i++) {
+        d.pushBack(i);
+    }
+
+    d.reverse();
+    checkTest("testReverseAndRotate #1", "15 14 13 12 11 10", d.getListAsString());
+    checkTest("testReverseAndRotate #2", "10 11 12 13 14 15", d.getListBackwardsAsString());
+    checkTest("testReverseAndRotate #3", 15, d.get(0));
+    d[1] = 1400;
+    checkTest("testReverseAndRotate #4", "15 1400 13 12 11 10", d.getListAsString());
+
+    //Edits follow the reversed direction
+    d.pushFront(16);
+    d.pushBack(9);
+    d.insert(2, 155);
+    d.insert(9, 8);
+    d.remove(3);
+    checkTest("testReverseAndRotate #5", "16 15 155 13 12 11 10 9 8", d.getListAsString());
+    checkTest("testReverseAndRotate #6", "8 9 10 11 12 13 155 15 16", d.getListBackwardsAsString());
+    d.deleteFirst();
+    d.deleteLast();
+    checkTest("testReverseAndRotate #7", "15 155 13 12 11 10 9", d.getListAsString());
+
+    //A copy keeps the order it was shown in
+    DoublyLinkedList<int, LazyDeletePolicies> copy(d);
+    checkTest("testReverseAndRotate #8", false, copy.isReversed());
+    checkTest("testReverseAndRotate #9", "15 155 13 12 11 10 9", copy.getListAsString());
+
+    d.reverse();
+    checkTest("testReverseAndRotate #10", "9 10 11 12 13 155 15", d.getListAsString());
+    checkTest("testReverseAndRotate #11", "15 155 13 12 11 10 9", d.getListBackwardsAsString());
+
+    //Rotating walks from whichever end is closer
+    d.rotate(2);
+    checkTest("testReverseAndRotate #12", "11 12 13 155 15 9 10", d.getListAsString());
+    checkTest("testReverseAndRotate #13", "10 9 15 155 13 12 11", d.getListBackwardsAsString());
+    d.rotate(6);
+    checkTest("testReverseAndRotate #14", "10 11 12 13 155 15 9", d.getListAsString());
+    d.rotate(-1);
+    checkTest("testReverseAndRotate #15", "9 10 11 12 13 155 15", d.getListAsString());
+    d.rotate(14);
+    checkTest("testReverseAndRotate #16", "9 10 11 12 13 155 15", d.getListAsString());
+
+    d.reverse();
+    d.rotate(1);
+    checkTest("testReverseAndRotate #17", "155 13 12 11 10 9 15", d.getListAsString());
+    checkTest("testReverseAndRotate #18", "15 9 10 11 12 13 155", d.getListBackwardsAsString());
+    d.rotate(-2);
+    checkTest("testReverseAndRotate #19", "9 15 155 13 12 11 10", d.getListAsString());
+    checkTest("testReverseAndRotate #20", "10 11 12 13 155 15 9", d.getListBackwardsAsString());
+
+    //Tombstones are skipped when counting positions
+    d.setLazyDeletion(true);
+    d.setCompactionRatio(1.0);
+    d.remove(1);
+    d.remove(4);
+    d.rotate(2);
+    checkTest("testReverseAndRotate #21", "13 12 10 9 155", d.getListAsString());
+    checkTest("testReverseAndRotate #22", "155 9 10 12 13", d.getListBackwardsAsString());
+    d.rotate(-1);
+    checkTest("testReverseAndRotate #23", "155 13 12 10 9", d.getListAsString());
+    d.compact();
+    checkTest("testReverseAndRotate #24", "9 10 12 13 155", d.getListBackwardsAsString());
+
+    //Batched edits on a reversed list match sequential edits
+    vector<ListEdit<int>> edits;
+    edits.push_back(ListEdit<int>::insertAt(0, 1));
+    edits.push_back(ListEdit<int>::removeAt(2));
+    edits.push_back(ListEdit<int>::insertAt(5, 2));
+    DoublyLinkedList<int, LazyDeletePolicies> sequential(d);
+    for (const ListEdit<int>& edit : edits) {
+        if (edit.kind == ListEdit<int>::Kind::Insert) {
+            sequential.insert(edit.index, edit.value);
+        }
+        else {
+            sequential.remove(edit.index);
+        }
+    }
+    d.applyBatch(edits);
+    checkTest("testReverseAndRotate #25", sequential.getListAsString(), d.getListAsString());
+    checkTest("testReverseAndRotate #26", sequential.getListBackwardsAsString(), d.getListBackwardsAsString());
+
+    DoublyLinkedList<int> empty;
+    empty.reverse();
+    empty.rotate(3);
+    empty.pushBack(1);
+    empty.pushBack(2);
+    checkTest("testReverseAndRotate #27", "1 2", empty.getListAsString());
+
+    //Without a count rotate finds the new head without knowing the size, unless k is at least the size
+    DoublyLinkedList<int, ListPolicies<NoCount, NoBoundsCheck, NoDiagnostics, MakeSharedAlloc, SingleThreaded, LazyDelete>> uncounted;
+    for (int i = 1; i <= 6; i++) {
+        uncounted.pushBack(i);
+    }
+    uncounted.rotate(2);
+    checkTest("testReverseAndRotate #28", "3 4 5 6 1 2", uncounted.getListAsString());
+    uncounted.rotate(-1);
+    checkTest("testReverseAndRotate #29", "2 3 4 5 6 1", uncounted.getListAsString());
+    uncounted.rotate(13);
+    checkTest("testReverseAndRotate #30", "3 4 5 6 1 2", uncounted.getListAsString());
+    uncounted.rotate(-6);
+    checkTest("testReverseAndRotate #31", "3 4 5 6 1 2", uncounted.getListAsString());
+    uncounted.reverse();
+    uncounted.setLazyDeletion(true);
+    uncounted.remove(1);
+    uncounted.rotate(-8);
+    checkTest("testReverseAndRotate #32", "5 4 3 2 6", uncounted.getListAsString());
+    checkTest("testReverseAndRotate #33", "6 2 3 4 5", uncounted.getListBackwardsAsString());
+}
+
+//Constructed before the reclaimer, so it is destroyed after the reclaimer shuts down at exit
+DoublyLinkedList<int, DeferredReclaimPolicies> exitTimeList;
+
+void testReclaim() {
+    //Immediate mode frees on the calling thread
+    DoublyLinkedList<int>* d = new DoublyLinkedList<int>;
+    for (int i = 0; i < 1000000; i++) {
+        d->pushBack(i);
+    }
+    auto start = std::chrono::high_resolution_clock::now();
+    delete d;
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::micro> diff = end - start;
+    cout << "    Destroying 1,000,000 numbers took " << (diff.count() / 1000.0) << " milliseconds on the calling thread." << endl;
+
+    //Background mode only detaches the chain
+    DoublyLinkedList<int, DeferredReclaimPolicies>* deferred = new DoublyLinkedList<int, DeferredReclaimPolicies>;
+    for (int i = 0; i < 1000000; i++) {
+        deferred->pushBack(i);
+    }
+    deferred->setReclaimMode(ReclaimMode::Background);
+    start = std::chrono::high_resolution_clock::now();
+    delete deferred;
+    end = std::chrono::high_resolution_clock::now();
+    diff = end - start;
+    cout << "    Destroying 1,000,000 numbers took " << (diff.count() / 1000.0) << " milliseconds with background reclaiming." << endl;
+
+    DoublyLinkedList<string, DeferredReclaimPolicies> words;
+    words.setReclaimMode(ReclaimMode::Background);
+    for (int i = 0; i < 1000; i++) {
+        words.pushBack("word");
+    }
+    words.clear();
+    checkTest("testReclaim #1", "The list is empty.", words.getListAsString());
+    words.pushBack("again");
+    checkTest("testReclaim #2", "again", words.getListAsString());
+    ChainReclaimer::instance().waitUntilIdle();
+
+    //Incremental mode frees a chunk for every new node
+    DoublyLinkedList<int, DeferredReclaimPolicies> chunked;
+    chunked.setReclaimMode(ReclaimMode::Incremental, 1000);
+    for (int i = 0; i < 5000; i++) {
+        chunked.pushBack(i);
+    }
+    chunked.clear();
+    checkTest("testReclaim #3", true, chunked.hasPendingReclaim());
+    checkTest("testReclaim #4", 0, chunked.getLiveCount());
+    checkTest("testReclaim #5", 2000, chunked.reclaimPending(2000));
+
+    //A second clear() queues behind the first
+    chunked.pushBack(1);
+    chunked.pushBack(2);
+    chunked.clear();
+    chunked.pushBack(3);
+    checkTest("testReclaim #6", "3", chunked.getListAsString());
+    checkTest("testReclaim #7", 2, chunked.reclaimPending(5000));
+    checkTest("testReclaim #8", false, chunked.hasPendingReclaim());
+
+    //Switching modes releases the leftovers
+    chunked.clear();
+    chunked.setReclaimMode(ReclaimMode::Immediate);
+    checkTest("testReclaim #9", false, chunked.hasPendingReclaim());
+    chunked.pushBack(4);
+    checkTest("testReclaim #10", "4", chunked.getListBackwardsAsString());
+
+    //Destroying a list with pending chains frees them too
+    DoublyLinkedList<int, DeferredReclaimPolicies>* pending = new DoublyLinkedList<int, DeferredReclaimPolicies>;
+    pending->setReclaimMode(ReclaimMode::Incremental, 10);
+    for (int i = 0; i < 100; i++) {
+        pending->pushBack(i);
+    }
+    pending->clear();
+    delete pending;
+
+    //A copy shares node blocks, each new node still frees no more than a chunk of its values
+    shared_ptr<int> token = make_shared<int>(0);
+    DoublyLinkedList<shared_ptr<int>, DeferredReclaimPolicies> tokens;
+    for (int i = 0; i < 1000; i++) {
+        tokens.pushBack(token);
+    }
+    DoublyLinkedList<shared_ptr<int>, DeferredReclaimPolicies> tokensCopy = tokens.clone();
+    tokensCopy.setReclaimMode(ReclaimMode::Incremental, 10);
+    tokensCopy.clear();
+    long largestChunk = 0;
+    while (tokensCopy.hasPendingReclaim()) {
+        const long before = token.use_count();
+        tokensCopy.pushBack(nullptr);
+        largestChunk = std::max(largestChunk, before - token.use_count());
+    }
+    checkTest("testReclaim #12", 10, static_cast<int>(largestChunk));
+    checkTest("testReclaim #13", 1001, static_cast<int>(token.use_count()));
+
+    DoublyLinkedList<string, DeferredReclaimPolicies> manyWords;
+    for (int i = 0; i < 1000000; i++) {
+        manyWords.pushBack("a word too long for the small string buffer");
+    }
+    DoublyLinkedList<string, DeferredReclaimPolicies> manyWordsCopy = manyWords.clone();
+    manyWordsCopy.setReclaimMode(ReclaimMode::Incremental, 1024);
+    manyWordsCopy.clear();
+    double slowestPush = 0.0;
+    while (manyWordsCopy.hasPendingReclaim()) {
+        start = std::chrono::high_resolution_clock::now();
+        manyWordsCopy.pushBack("new");
+        end = std::chrono::high_resolution_clock::now();
+        diff = end - start;
+        slowestPush = std::max(slowestPush, diff.count());
+    }
+    cout << "    The slowest pushBack while reclaiming a copy of 1,000,000 strings took " << (slowestPush / 1000.0) << " milliseconds." << endl;
+
+    //A list that outlives the reclaimer frees its nodes itself, checked by running under a leak checker
+    exitTimeList.setReclaimMode(ReclaimMode::Background);
+    for (int i = 0; i < 1000; i++) {
+        exitTimeList.pushBack(i);
+    }
+    exitTimeList.clear();
+    for (int i = 0; i < 1000; i++) {
+        exitTimeList.pushBack(i);
+    }
+    checkTest("testReclaim #11", 1000, exitTimeList.getLiveCount());
+
+    //Lists without the DeferredReclaim policy keep none of its state
+    checkTest("testReclaim #14", true, sizeof(DoublyLinkedList<int>) < sizeof(DoublyLinkedList<int, DeferredReclaimPolicies>));
+    checkTest("testReclaim #15", false, DoublyLinkedList<int>().hasPendingReclaim());
+}
+
 void pressAnyKeyToContinue() {
     cout << "Press enter to continue...";
     cin.get();
@@ -814,5 +2733,33 @@ int main() {
 
     pressAnyKeyToContinue();
 
+    testLazyDeletion();
+
+    pressAnyKeyToContinue();
+
+    testCopy();
+
+    pressAnyKeyToContinue();
+
+    testLruCache();
+
+    pressAnyKeyToContinue();
+
+    testApplyBatch();
+
+    pressAnyKeyToContinue();
+
+    testPolicies();
+
+    pressAnyKeyToContinue();
+
+    testReverseAndRotate();
+
+    pressAnyKeyToContinue();
+
+    testReclaim();
+
+    pressAnyKeyToContinue();
+
     return 0;
 }